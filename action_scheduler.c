@@ -41,6 +41,7 @@ static uint8_t mNodeEndIdx = 0;
 static uint16_t mActiveNodes = 0;
 static uint32_t mProceedingTime = 0;    // specific for scheduling inside callback case
 static uint16_t mActiveNodesWaterMark = 0;  // For diagnostic purpose
+static uint8_t mClearCount = 0;    // Clear zeroes the used counters, this tells a node apart from one scheduled after a Clear
 // Lock/Unlock for interrupt/thread safety, if we want to use the functions in interrupt handler/multi threads
 // But if not, we don't need these
 static inline uint32_t ListLock(void)
@@ -192,6 +193,8 @@ bool ActionScheduler_Proceed(uint32_t timeElapsedMs)
         mActiveNodes -= 1U;
         ActionCallback_t cb = mNodes[currentCursor].callback;
         void* arg = mNodes[currentCursor].arg;
+        uint8_t usedCounter = mNodes[currentCursor].usedCounter;
+        uint8_t clearCount = mClearCount;
         if (mActiveNodes > 0U)
         {
             // isolate the node out from the timeline
@@ -208,14 +211,19 @@ bool ActionScheduler_Proceed(uint32_t timeElapsedMs)
         ListUnlock(lock);
         ActionReturn_t actionRet = cb(arg);
         lock = ListLock();
+        // The callback can unschedule or clear, then schedule a new event into this very slot, same as the unschedule bad luck exists when the counter rounds back
+        bool isOwned = (mNodes[currentCursor].usedCounter == usedCounter) && (mClearCount == clearCount);
         switch(actionRet)
         {
             case ACTION_ONESHOT:
-                mNodes[currentCursor].callback = NULL;
+                if (isOwned)
+                {
+                    mNodes[currentCursor].callback = NULL;
+                }
             break;
             case ACTION_RELOAD:
                 // The callback can unschedule this, result in callback changed to null, we need to check this
-                if(mNodes[currentCursor].callback != NULL)
+                if(isOwned && (mNodes[currentCursor].callback != NULL))
                 {
                     if (mActiveNodes == 0U) //the linked list is empty, this is the first node
                     {
@@ -335,24 +343,24 @@ bool ActionScheduler_Unschedule(ActionSchedulerId_t* actionId)
     return ret;
 }
 
-// Relatively safer to the version that use ActionSchedulerId, and it traverse through all the internal linked list node
+// Relatively safer to the version that use ActionSchedulerId, and it goes through all the node slots
+// So same as ActionScheduler_Unschedule, the node whose callback is running right now (isolated from the timeline) is unscheduled too, its ACTION_RELOAD is dropped
 bool ActionScheduler_UnscheduleAll(ActionCallback_t cb)
 {
     bool ret = false;
+    if (cb == NULL)
+    {
+        return ret;
+    }
     uint32_t lock = ListLock();
-    uint8_t currentCursor = mNodeStartIdx;
-    uint8_t nextCursor = currentCursor;
-    bool isEnd;
-    do{
-        currentCursor = nextCursor;
-        nextCursor = mNodes[currentCursor].nextNodeIdx;
-        isEnd = currentCursor == mNodeEndIdx;
-        if (mNodes[currentCursor].callback == cb)
+    for (uint16_t i = 0; i < MAX_ACTION_SCHEDULER_NODES; i++)
+    {
+        if (mNodes[i].callback == cb)
         {
             ret = true;
-            removeNodeAt(currentCursor);
+            removeNodeAt((uint8_t)i);
         }
-    } while (!isEnd);
+    }
     ListUnlock(lock);
     return ret;
 }
@@ -374,6 +382,7 @@ void ActionScheduler_Clear()
     mNodeEndIdx = 0;
     mActiveNodes = 0;
     mProceedingTime = 0;
+    mClearCount++;
     ListUnlock(lock);
 }
 
@@ -0,0 +1,970 @@
+//
+// Randomized harness for the ActionScheduler timeline
+//
+// A stream of bytes is decoded into interleaved Schedule/ScheduleReload/Unschedule/UnscheduleAll/Proceed/Clear calls
+// Callbacks decode further bytes from the same stream to chain new events, reload, unschedule themselves and others, UnscheduleAll, Clear
+// and query IsCallbackArmed from inside the timeline, the firing event is modelled explicitly as armed until it returns or is unscheduled
+// Every call is mirrored into a reference model which keeps absolute fire times and an insertion sequence per event
+// The model predicts which event must fire next (earliest time, FIFO on ties), when it fires, and what GetNextEventDelay returns
+// Any mismatch prints the step and aborts, so the same source works as a libFuzzer target and as a standalone test
+// The scheduler source is included directly, so the linked list itself can be walked as well, a corrupted list fails instead of looping forever
+//
+// Standalone usage (the flags follow libFuzzer spelling so the ctest entry works for both builds):
+//   fuzz_action_scheduler [-runs=N] [-seed=S] [-steps=N] [-soak=SECONDS] [-trace=1] [crash files...]
+//   -runs/-seed/-steps  run N pseudo random inputs of N steps each, starting from seed S
+//   -soak               keep one endless pseudo random stream going for SECONDS instead
+//   -replays/-record    replay the first N recorded scheduler calls (default 1M) in N timed batches (default 10, 0 to skip)
+// The checked run records every ActionScheduler_* call it makes, calls from callbacks and callback returns included
+// The throughput is measured by replaying that recording alone, no model and no checks, one clock pair per batch
+//   -trace              print every call and callback, to follow a failing seed or input
+//   files               replay inputs saved by libFuzzer
+// Configure with -DACTION_SCHEDULER_LIBFUZZER=ON (clang) to build the libFuzzer target instead
+//
+#include "action_scheduler.c"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+uint32_t Enter_Critical() {return 0;}
+void Exit_Critical(uint32_t lock) {}
+
+#define FUZZ_CALLBACKS 4U
+// Callbacks fired within one Proceed before the callbacks stop reloading and chaining, so every Proceed terminates
+#define FUZZ_FIRE_BUDGET 512U
+#define FUZZ_DEAD_IDS 8U
+// One extra record, a firing event that unscheduled itself no longer holds a node but its record is alive until the callback returns
+#define MODEL_EVENTS (MAX_ACTION_SCHEDULER_NODES + 1U)
+#define MODEL_NONE MODEL_EVENTS
+
+#define FUZZ_TRACE(...) do { if (mTrace) { printf(__VA_ARGS__); } } while (0)
+#define FUZZ_CHECK(cond) do { if (!(cond)) { fuzzFail(#cond, __LINE__); } } while (0)
+
+typedef enum
+{
+    MODEL_FREE,
+    MODEL_PENDING,
+    MODEL_FIRING,
+    MODEL_FIRING_CANCELLED
+}ModelState_t;
+
+typedef struct
+{
+    ModelState_t state;
+    ActionSchedulerId_t id;
+    uint8_t cbIdx;
+    uint32_t reload;
+    uint64_t fireTime;
+    uint64_t seq;
+}ModelEvent_t;
+
+typedef struct
+{
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint64_t prng;  // when data is NULL, bytes are drawn from a xorshift generator instead
+}FuzzInput_t;
+
+static FuzzInput_t mInput;
+static ModelEvent_t mModel[MODEL_EVENTS];
+static uint64_t mModelNow = 0;
+static uint64_t mModelSeq = 0;
+static ActionSchedulerId_t mDeadIds[FUZZ_DEAD_IDS];
+static uint8_t mDeadIdCursor = 0;
+// State of the Proceed call in flight, used to validate the callbacks
+static bool mInProceed = false;
+static uint64_t mProceedStart = 0;
+static uint64_t mProceedTarget = 0;
+static uint32_t mProceedingTimeBase = 0;
+static uint32_t mFireBudget = 0;
+// Statistics, also used for the failure report
+static uint64_t mSteps = 0;
+static uint64_t mRunSeed = 0;
+static uint64_t mRunSteps = 0;
+static uint64_t mFires = 0;
+static bool mTrace = false;
+
+typedef enum
+{
+    REPLAY_SCHEDULE,
+    REPLAY_SCHEDULE_RELOAD,
+    REPLAY_UNSCHEDULE,
+    REPLAY_UNSCHEDULE_ALL,
+    REPLAY_PROCEED,
+    REPLAY_CLEAR,
+    REPLAY_RETURN
+}ReplayType_t;
+
+typedef struct
+{
+    uint8_t type;
+    uint8_t cbIdx;
+    ActionSchedulerId_t id;     // returned by a schedule, or passed to an unschedule
+    uint32_t delay;             // also the elapsed time of a proceed, or the value returned by a callback
+    uint32_t reload;
+}ReplayOp_t;
+
+// Recording of the scheduler calls, NULL unless the standalone driver asked for one
+static ReplayOp_t* mReplay = NULL;
+static size_t mReplayCapacity = 0;
+static size_t mReplayCount = 0;
+static size_t mReplayCommitted = 0;     // whole steps only, a replay must not stop in the middle of a callback
+static bool mReplayFull = false;
+
+static void fuzzFail(const char* expr, int line)
+{
+    fflush(stdout);
+    fprintf(stderr, "Timeline invariant violated at line %d: %s\n", line, expr);
+    fprintf(stderr, "  during step %llu of this run, model time %llu, input offset %lu\n",
+        (unsigned long long)(mRunSteps + 1U), (unsigned long long)mModelNow, (unsigned long)mInput.pos);
+    if (mInput.data == NULL)
+    {
+        // Soak and -runs streams start the same way for one seed, so this replays either of them
+        fprintf(stderr, "  reproduce with -seed=%llu -runs=1 -steps=%llu -trace=1\n",
+            (unsigned long long)mRunSeed, (unsigned long long)(mRunSteps + 1U));
+    }
+    abort();
+}
+
+static void recordOp(ReplayType_t type, uint8_t cbIdx, ActionSchedulerId_t id, uint32_t delay, uint32_t reload)
+{
+    if ((mReplay == NULL) || mReplayFull)
+    {
+        return;
+    }
+    if (mReplayCount >= mReplayCapacity)
+    {
+        // Keep what was committed so far, the step in flight is dropped
+        mReplayFull = true;
+        return;
+    }
+    ReplayOp_t* op = &mReplay[mReplayCount++];
+    op->type = (uint8_t)type;
+    op->cbIdx = cbIdx;
+    op->id = id;
+    op->delay = delay;
+    op->reload = reload;
+}
+
+static void recordCommit(void)
+{
+    if (!mReplayFull)
+    {
+        mReplayCommitted = mReplayCount;
+    }
+}
+
+static bool inputExhausted(void)
+{
+    return (mInput.data != NULL) && (mInput.pos >= mInput.size);
+}
+
+// Exhausted input reads as zeros, which decodes to callbacks doing nothing but a one shot return
+static uint8_t nextByte(void)
+{
+    if (mInput.data == NULL)
+    {
+        mInput.prng ^= mInput.prng << 13;
+        mInput.prng ^= mInput.prng >> 7;
+        mInput.prng ^= mInput.prng << 17;
+        mInput.pos++;
+        return (uint8_t)(mInput.prng >> 24);
+    }
+    if (mInput.pos < mInput.size)
+    {
+        return mInput.data[mInput.pos++];
+    }
+    return 0U;
+}
+
+static uint16_t nextWord(void)
+{
+    uint16_t hi = nextByte();
+    return (uint16_t)((hi << 8) | nextByte());
+}
+
+static void modelReset(void)
+{
+    memset(mModel, 0, sizeof(mModel));
+    for (uint8_t i = 0; i < FUZZ_DEAD_IDS; i++)
+    {
+        mDeadIds[i] = ACTION_SCHEDULER_ID_INVALID;
+    }
+    mDeadIdCursor = 0;
+    mModelNow = 0;
+    mModelSeq = 0;
+}
+
+// Events holding a node in the scheduler, the firing one keeps its node until it returns
+static uint32_t modelOccupied(void)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < MODEL_EVENTS; i++)
+    {
+        if ((mModel[i].state == MODEL_PENDING) || (mModel[i].state == MODEL_FIRING))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+static uint32_t modelEarliest(void)
+{
+    uint32_t best = MODEL_NONE;
+    for (uint32_t i = 0; i < MODEL_EVENTS; i++)
+    {
+        if (mModel[i].state != MODEL_PENDING)
+        {
+            continue;
+        }
+        if ((best == MODEL_NONE) || (mModel[i].fireTime < mModel[best].fireTime) ||
+            ((mModel[i].fireTime == mModel[best].fireTime) && (mModel[i].seq < mModel[best].seq)))
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static uint32_t modelFindLive(ActionSchedulerId_t id)
+{
+    for (uint32_t i = 0; i < MODEL_EVENTS; i++)
+    {
+        if (((mModel[i].state == MODEL_PENDING) || (mModel[i].state == MODEL_FIRING)) && (mModel[i].id == id))
+        {
+            return i;
+        }
+    }
+    return MODEL_NONE;
+}
+
+// Pick the n-th record in the given states, wrapping around
+static uint32_t modelPick(uint8_t n, bool includeFiring)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < MODEL_EVENTS; i++)
+    {
+        if ((mModel[i].state == MODEL_PENDING) || (includeFiring && (mModel[i].state == MODEL_FIRING)))
+        {
+            count++;
+        }
+    }
+    if (count == 0U)
+    {
+        return MODEL_NONE;
+    }
+    n = (uint8_t)(n % count);
+    for (uint32_t i = 0; i < MODEL_EVENTS; i++)
+    {
+        if ((mModel[i].state == MODEL_PENDING) || (includeFiring && (mModel[i].state == MODEL_FIRING)))
+        {
+            if (n == 0U)
+            {
+                return i;
+            }
+            n--;
+        }
+    }
+    return MODEL_NONE;
+}
+
+static void modelRetire(uint32_t idx)
+{
+    mDeadIds[mDeadIdCursor] = mModel[idx].id;
+    mDeadIdCursor = (uint8_t)((mDeadIdCursor + 1U) % FUZZ_DEAD_IDS);
+    mModel[idx].state = MODEL_FREE;
+}
+
+// Mix of immediate, short, long and exact-tie delays, the ties exercise the FIFO ordering of equal fire times
+static uint32_t nextDelay(void)
+{
+    uint8_t b = nextByte();
+    switch (b & 0x03U)
+    {
+        case 0:
+            return 0U;
+        case 1:
+            return nextByte() % 16U;
+        case 2:
+        {
+            uint32_t idx = modelPick(nextByte(), false);
+            if (idx != MODEL_NONE)
+            {
+                return (uint32_t)(mModel[idx].fireTime - mModelNow);
+            }
+            return b >> 2;
+        }
+        default:
+            return nextWord();
+    }
+}
+
+static ActionReturn_t onFire(uint8_t cbIdx, void* arg);
+static ActionReturn_t fuzzCallback0(void* arg) { return onFire(0U, arg); }
+static ActionReturn_t fuzzCallback1(void* arg) { return onFire(1U, arg); }
+static ActionReturn_t fuzzCallback2(void* arg) { return onFire(2U, arg); }
+static ActionReturn_t fuzzCallback3(void* arg) { return onFire(3U, arg); }
+static const ActionCallback_t mCallbacks[FUZZ_CALLBACKS] = {fuzzCallback0, fuzzCallback1, fuzzCallback2, fuzzCallback3};
+
+static void checkTimeline(void)
+{
+    uint32_t next = modelEarliest();
+    uint32_t expectedDelay = (next == MODEL_NONE) ? UINT32_MAX : (uint32_t)(mModel[next].fireTime - mModelNow);
+    FUZZ_CHECK(ActionScheduler_GetNextEventDelay() == expectedDelay);
+}
+
+// Walk the timeline the scheduler really holds, the hops are bounded so a cycle fails instead of looping forever
+// Every linked node must belong to a pending model event and accumulate to exactly its fire time
+static void checkLinks(void)
+{
+    if (mActiveNodes == 0U)
+    {
+        return;
+    }
+    FUZZ_CHECK(mActiveNodes <= MAX_ACTION_SCHEDULER_NODES);
+    FUZZ_CHECK(mNodes[mNodeStartIdx].previousNodeIdx == mNodeStartIdx);
+    uint8_t cursor = mNodeStartIdx;
+    uint64_t fireTime = mModelNow;
+    uint16_t hops = 1U;
+    while (true)
+    {
+        const ModelEvent_t* ev = (const ModelEvent_t*)mNodes[cursor].arg;
+        FUZZ_CHECK(mNodes[cursor].callback != NULL);
+        FUZZ_CHECK((ev >= &mModel[0]) && (ev < &mModel[MODEL_EVENTS]));
+        fireTime += mNodes[cursor].delayToPrevious;
+        FUZZ_CHECK(ev->state == MODEL_PENDING);
+        FUZZ_CHECK(ev->fireTime == fireTime);
+        if (cursor == mNodeEndIdx)
+        {
+            break;
+        }
+        uint8_t next = mNodes[cursor].nextNodeIdx;
+        FUZZ_CHECK((next < MAX_ACTION_SCHEDULER_NODES) && (next != cursor));
+        FUZZ_CHECK(mNodes[next].previousNodeIdx == cursor);
+        cursor = next;
+        hops++;
+        if (hops > MAX_ACTION_SCHEDULER_NODES)
+        {
+            fuzzFail("timeline walk ran past MAX_ACTION_SCHEDULER_NODES hops", __LINE__);
+        }
+    }
+    FUZZ_CHECK(mNodes[mNodeEndIdx].nextNodeIdx == mNodeEndIdx);
+    FUZZ_CHECK(hops == mActiveNodes);
+}
+
+static void checkArmed(void)
+{
+    for (uint8_t cb = 0; cb < FUZZ_CALLBACKS; cb++)
+    {
+        bool armed = false;
+        for (uint32_t i = 0; i < MODEL_EVENTS; i++)
+        {
+            if (((mModel[i].state == MODEL_PENDING) || (mModel[i].state == MODEL_FIRING)) && (mModel[i].cbIdx == cb))
+            {
+                armed = true;
+            }
+        }
+        FUZZ_CHECK(ActionScheduler_IsCallbackArmed(mCallbacks[cb]) == armed);
+    }
+}
+
+static void doSchedule(void);
+static void doUnschedule(void);
+static void doUnscheduleAll(void);
+static void doClear(void);
+
+static ActionReturn_t onFire(uint8_t cbIdx, void* arg)
+{
+    ModelEvent_t* ev = (ModelEvent_t*)arg;
+    uint32_t idx = modelEarliest();
+    FUZZ_CHECK(mInProceed);
+    FUZZ_CHECK(idx != MODEL_NONE);
+    FUZZ_CHECK(ev == &mModel[idx]);
+    FUZZ_CHECK(ev->cbIdx == cbIdx);
+    FUZZ_CHECK(ev->fireTime <= mProceedTarget);
+    FUZZ_CHECK(ev->fireTime >= mModelNow);
+    mModelNow = ev->fireTime;
+    mFires++;
+    FUZZ_CHECK(ActionScheduler_GetProceedingTime() == (uint32_t)(mProceedingTimeBase + (uint32_t)(mModelNow - mProceedStart)));
+    ev->state = MODEL_FIRING;
+    checkLinks();
+    FUZZ_TRACE("  fire %04x cb%u at %llu\n", ev->id, cbIdx, (unsigned long long)mModelNow);
+
+    ActionReturn_t ret = ACTION_ONESHOT;
+    if (mFireBudget > 0U)
+    {
+        mFireBudget--;
+        uint8_t b = nextByte();
+        if ((b & 0x01U) != 0U)
+        {
+            ret = ACTION_RELOAD;
+        }
+        if ((b & 0x02U) != 0U)
+        {
+            doSchedule();
+        }
+        if ((b & 0x04U) != 0U)
+        {
+            ActionSchedulerId_t self = ev->id;
+            bool expected = (ev->state == MODEL_FIRING);
+            FUZZ_TRACE("  unschedule self %04x\n", self);
+            recordOp(REPLAY_UNSCHEDULE, 0U, self, 0U, 0U);
+            bool unscheduled = ActionScheduler_Unschedule(&self);
+            FUZZ_CHECK(unscheduled == expected);
+            if (expected)
+            {
+                FUZZ_CHECK(self == ACTION_SCHEDULER_ID_INVALID);
+                ev->state = MODEL_FIRING_CANCELLED;
+            }
+        }
+        if ((b & 0x08U) != 0U)
+        {
+            doUnschedule();
+        }
+        // Rare as well, it wipes a whole callback from the timeline and would keep it from ever filling up
+        if (((b & 0x60U) == 0x60U) && (nextByte() < 32U))
+        {
+            doUnscheduleAll();
+        }
+        // Rare, a Clear followed by the schedule below can hand the firing slot out again with the very same counter
+        if (((b & 0x80U) != 0U) && (nextByte() == 0U))
+        {
+            doClear();
+        }
+        if ((b & 0x10U) != 0U)
+        {
+            doSchedule();
+        }
+        if ((b & 0x40U) != 0U)
+        {
+            checkArmed();
+        }
+        checkTimeline();
+        checkLinks();
+    }
+
+    FUZZ_TRACE("  return %s from %04x\n", (ret == ACTION_RELOAD) ? "reload" : "oneshot", ev->id);
+    if ((ret == ACTION_RELOAD) && (ev->state == MODEL_FIRING))
+    {
+        ev->state = MODEL_PENDING;
+        ev->fireTime = mModelNow + ev->reload;
+        ev->seq = mModelSeq++;
+    }
+    else
+    {
+        modelRetire(idx);
+    }
+    recordOp(REPLAY_RETURN, cbIdx, ACTION_SCHEDULER_ID_INVALID, (uint32_t)ret, 0U);
+    return ret;
+}
+
+static void doSchedule(void)
+{
+    uint8_t cbIdx = (uint8_t)(nextByte() % FUZZ_CALLBACKS);
+    bool useReload = (nextByte() & 0x01U) != 0U;
+    uint32_t delay = nextDelay();
+    uint32_t reload = useReload ? nextDelay() : delay;
+    bool expectOk = modelOccupied() < MAX_ACTION_SCHEDULER_NODES;
+    uint32_t idx = MODEL_NONE;
+    for (uint32_t i = 0; i < MODEL_EVENTS; i++)
+    {
+        if (mModel[i].state == MODEL_FREE)
+        {
+            idx = i;
+            break;
+        }
+    }
+    void* arg = (idx != MODEL_NONE) ? &mModel[idx] : NULL;
+
+    ActionSchedulerId_t id;
+    if (useReload)
+    {
+        id = ActionScheduler_ScheduleReload(delay, reload, mCallbacks[cbIdx], arg);
+    }
+    else
+    {
+        id = ActionScheduler_Schedule(delay, mCallbacks[cbIdx], arg);
+    }
+    recordOp(useReload ? REPLAY_SCHEDULE_RELOAD : REPLAY_SCHEDULE, cbIdx, id, delay, reload);
+
+    FUZZ_TRACE("schedule cb%u delay %lu reload %lu -> %04x\n", cbIdx, (unsigned long)delay, (unsigned long)reload, id);
+    if (!expectOk)
+    {
+        FUZZ_CHECK(id == ACTION_SCHEDULER_ID_INVALID);
+        return;
+    }
+    FUZZ_CHECK(id != ACTION_SCHEDULER_ID_INVALID);
+    FUZZ_CHECK(idx != MODEL_NONE);
+    FUZZ_CHECK(modelFindLive(id) == MODEL_NONE);
+    mModel[idx].state = MODEL_PENDING;
+    mModel[idx].id = id;
+    mModel[idx].cbIdx = cbIdx;
+    mModel[idx].reload = reload;
+    mModel[idx].fireTime = mModelNow + delay;
+    mModel[idx].seq = mModelSeq++;
+}
+
+// Unschedule a live event, a recently expired one, or garbage
+static void doUnschedule(void)
+{
+    uint8_t b = nextByte();
+    ActionSchedulerId_t id;
+    switch (b & 0x03U)
+    {
+        case 0:
+        case 1:
+        {
+            uint32_t idx = modelPick(nextByte(), true);
+            id = (idx != MODEL_NONE) ? mModel[idx].id : ACTION_SCHEDULER_ID_INVALID;
+            break;
+        }
+        case 2:
+            id = mDeadIds[nextByte() % FUZZ_DEAD_IDS];
+            break;
+        default:
+            id = nextWord();
+            break;
+    }
+
+    ActionSchedulerId_t requested = id;
+    uint32_t idx = (id != ACTION_SCHEDULER_ID_INVALID) ? modelFindLive(id) : MODEL_NONE;
+    recordOp(REPLAY_UNSCHEDULE, 0U, requested, 0U, 0U);
+    bool ret = ActionScheduler_Unschedule(&id);
+    FUZZ_TRACE("unschedule %04x -> %d\n", requested, ret);
+    FUZZ_CHECK(ret == (idx != MODEL_NONE));
+    if (ret)
+    {
+        FUZZ_CHECK(id == ACTION_SCHEDULER_ID_INVALID);
+        if (mModel[idx].state == MODEL_FIRING)
+        {
+            mModel[idx].state = MODEL_FIRING_CANCELLED;
+        }
+        else
+        {
+            modelRetire(idx);
+        }
+    }
+    else
+    {
+        FUZZ_CHECK(id == requested);
+    }
+}
+
+static void doUnscheduleAll(void)
+{
+    uint8_t cbIdx = (uint8_t)(nextByte() % FUZZ_CALLBACKS);
+    bool expected = false;
+    for (uint32_t i = 0; i < MODEL_EVENTS; i++)
+    {
+        if ((mModel[i].state == MODEL_PENDING) && (mModel[i].cbIdx == cbIdx))
+        {
+            expected = true;
+            modelRetire(i);
+        }
+        else if ((mModel[i].state == MODEL_FIRING) && (mModel[i].cbIdx == cbIdx))
+        {
+            // Same as an Unschedule by id, the running event is taken out and its ACTION_RELOAD is dropped
+            expected = true;
+            mModel[i].state = MODEL_FIRING_CANCELLED;
+        }
+    }
+    FUZZ_TRACE("unschedule all cb%u\n", cbIdx);
+    recordOp(REPLAY_UNSCHEDULE_ALL, cbIdx, ACTION_SCHEDULER_ID_INVALID, 0U, 0U);
+    bool ret = ActionScheduler_UnscheduleAll(mCallbacks[cbIdx]);
+    FUZZ_CHECK(ret == expected);
+}
+
+static void doProceed(void)
+{
+    uint8_t b = nextByte();
+    uint32_t elapsed;
+    switch (b & 0x03U)
+    {
+        case 0:
+            elapsed = 0U;
+            break;
+        case 1:
+            elapsed = nextByte() % 32U;
+            break;
+        case 2:
+        {
+            // Land right before, on, or right after the next event
+            uint32_t next = ActionScheduler_GetNextEventDelay();
+            elapsed = (next == UINT32_MAX) ? 1U : next;
+            if (((b & 0x0CU) == 0x04U) && (elapsed > 0U))
+            {
+                elapsed--;
+            }
+            else if ((b & 0x0CU) == 0x08U)
+            {
+                elapsed++;
+            }
+            break;
+        }
+        default:
+            elapsed = nextWord();
+            break;
+    }
+
+    uint32_t next = modelEarliest();
+    bool expected = (next != MODEL_NONE) && (mModel[next].fireTime <= (mModelNow + elapsed));
+    mInProceed = true;
+    mProceedStart = mModelNow;
+    mProceedTarget = mModelNow + elapsed;
+    mProceedingTimeBase = ActionScheduler_GetProceedingTime();
+    mFireBudget = FUZZ_FIRE_BUDGET;
+    FUZZ_TRACE("proceed %lu from %llu\n", (unsigned long)elapsed, (unsigned long long)mModelNow);
+    // Recorded ahead of the call, the callbacks it fires record after it
+    recordOp(REPLAY_PROCEED, 0U, ACTION_SCHEDULER_ID_INVALID, elapsed, 0U);
+    bool ret = ActionScheduler_Proceed(elapsed);
+    FUZZ_CHECK(ret == expected);
+    mInProceed = false;
+    mModelNow = mProceedTarget;
+
+    next = modelEarliest();
+    FUZZ_CHECK((next == MODEL_NONE) || (mModel[next].fireTime > mModelNow));
+}
+
+static void doClear(void)
+{
+    FUZZ_TRACE("clear\n");
+    recordOp(REPLAY_CLEAR, 0U, ACTION_SCHEDULER_ID_INVALID, 0U, 0U);
+    ActionScheduler_Clear();
+    if (!mInProceed)
+    {
+        modelReset();
+        return;
+    }
+    // From a callback, the firing event stays alive until it returns but its ACTION_RELOAD is dropped
+    for (uint32_t i = 0; i < MODEL_EVENTS; i++)
+    {
+        if (mModel[i].state == MODEL_PENDING)
+        {
+            modelRetire(i);
+        }
+        else if (mModel[i].state == MODEL_FIRING)
+        {
+            mModel[i].state = MODEL_FIRING_CANCELLED;
+        }
+    }
+    // The proceeding time restarts from 0 at this fire time
+    mProceedingTimeBase = 0;
+    mProceedStart = mModelNow;
+}
+
+static void fuzzStep(void)
+{
+    uint8_t op = nextByte();
+    switch (op & 0x07U)
+    {
+        case 0:
+        case 1:
+            doSchedule();
+            break;
+        case 2:
+            doUnschedule();
+            break;
+        case 3:
+            doUnscheduleAll();
+            break;
+        case 7:
+            // Rare, a Clear throws away all the state built so far
+            if ((op & 0xF8U) == 0xF8U)
+            {
+                doClear();
+                break;
+            }
+            // Rare too, a burst runs the timeline into its capacity, random steps alone seldom get there
+            if ((op & 0xF8U) == 0xF0U)
+            {
+                for (uint16_t i = 0; i <= MAX_ACTION_SCHEDULER_NODES; i++)
+                {
+                    doSchedule();
+                }
+                break;
+            }
+            // fall through
+        default:
+            doProceed();
+            break;
+    }
+    checkTimeline();
+    checkLinks();
+    checkArmed();
+    // Counted once its checks pass, so a failure always reports the step it happened in
+    mSteps++;
+    mRunSteps++;
+    recordCommit();
+}
+
+static void fuzzBegin(const uint8_t* data, size_t size, uint64_t seed)
+{
+    mInput.data = data;
+    mInput.size = size;
+    mInput.pos = 0;
+    mInput.prng = (seed != 0U) ? seed : 0x9E3779B97F4A7C15ULL;
+    mRunSeed = seed;
+    mRunSteps = 0;
+    doClear();
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    fuzzBegin(data, size, 0U);
+    while (!inputExhausted())
+    {
+        fuzzStep();
+    }
+    return 0;
+}
+
+#ifndef ACTION_SCHEDULER_LIBFUZZER
+static bool mReplayValidate = false;
+static size_t mReplayCursor = 0;
+
+static ActionReturn_t replayRun(uint8_t cbIdx);
+static ActionReturn_t replayCallback0(void* arg) { return replayRun(0U); }
+static ActionReturn_t replayCallback1(void* arg) { return replayRun(1U); }
+static ActionReturn_t replayCallback2(void* arg) { return replayRun(2U); }
+static ActionReturn_t replayCallback3(void* arg) { return replayRun(3U); }
+static const ActionCallback_t mReplayCallbacks[FUZZ_CALLBACKS] = {replayCallback0, replayCallback1, replayCallback2, replayCallback3};
+
+// Run the recorded calls up to the return of the callback in flight, FUZZ_CALLBACKS at the top level
+// The scheduler is deterministic from the recorded Clear on, so the replay takes the same ids and fires the same callbacks
+static ActionReturn_t replayRun(uint8_t cbIdx)
+{
+    while (mReplayCursor < mReplayCommitted)
+    {
+        const ReplayOp_t* op = &mReplay[mReplayCursor++];
+        switch (op->type)
+        {
+            case REPLAY_SCHEDULE:
+            {
+                ActionSchedulerId_t id = ActionScheduler_Schedule(op->delay, mReplayCallbacks[op->cbIdx], NULL);
+                FUZZ_CHECK(!mReplayValidate || (id == op->id));
+                break;
+            }
+            case REPLAY_SCHEDULE_RELOAD:
+            {
+                ActionSchedulerId_t id = ActionScheduler_ScheduleReload(op->delay, op->reload, mReplayCallbacks[op->cbIdx], NULL);
+                FUZZ_CHECK(!mReplayValidate || (id == op->id));
+                break;
+            }
+            case REPLAY_UNSCHEDULE:
+            {
+                ActionSchedulerId_t id = op->id;
+                (void)ActionScheduler_Unschedule(&id);
+                break;
+            }
+            case REPLAY_UNSCHEDULE_ALL:
+                (void)ActionScheduler_UnscheduleAll(mReplayCallbacks[op->cbIdx]);
+                break;
+            case REPLAY_PROCEED:
+                (void)ActionScheduler_Proceed(op->delay);
+                break;
+            case REPLAY_CLEAR:
+                ActionScheduler_Clear();
+                break;
+            default:
+                FUZZ_CHECK(!mReplayValidate || (op->cbIdx == cbIdx));
+                return (ActionReturn_t)op->delay;
+        }
+    }
+    return ACTION_ONESHOT;
+}
+
+static void replayOnce(void)
+{
+    mReplayCursor = 0;
+    while (mReplayCursor < mReplayCommitted)
+    {
+        (void)replayRun(FUZZ_CALLBACKS);
+    }
+}
+
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void replayBatches(unsigned long long batches)
+{
+    uint64_t calls = 0;
+    for (size_t i = 0; i < mReplayCommitted; i++)
+    {
+        if (mReplay[i].type != REPLAY_RETURN)
+        {
+            calls++;
+        }
+    }
+    if (calls == 0U)
+    {
+        return;
+    }
+    // An untimed pass first, it checks the replay really takes the recorded ids and fires the recorded callbacks, and warms the caches up
+    mReplayValidate = true;
+    replayOnce();
+    mReplayValidate = false;
+
+    uint64_t bestNs = UINT64_MAX;
+    uint64_t totalNs = 0;
+    for (unsigned long long b = 0; b < batches; b++)
+    {
+        uint64_t start = nowNs();
+        replayOnce();
+        uint64_t elapsed = nowNs() - start;
+        totalNs += elapsed;
+        if (elapsed < bestNs)
+        {
+            bestNs = elapsed;
+        }
+    }
+    double bestPerCall = (double)bestNs / (double)calls;
+    double meanPerCall = (double)totalNs / (double)batches / (double)calls;
+    printf("Replay of %llu scheduler calls, model and checks left out: best %.1f ns per call (%.0f calls/s), mean %.1f ns per call over %llu batches\n",
+        (unsigned long long)calls, bestPerCall, 1e9 / bestPerCall, meanPerCall, batches);
+}
+
+static bool parseFlag(const char* arg, const char* name, unsigned long long* value)
+{
+    size_t len = strlen(name);
+    if ((strncmp(arg, name, len) == 0) && (arg[len] == '='))
+    {
+        *value = strtoull(&arg[len + 1U], NULL, 0);
+        return true;
+    }
+    return false;
+}
+
+static int replayFile(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "Can not open %s\n", path);
+        return 1;
+    }
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0)
+    {
+        size = ftell(f);
+    }
+    uint8_t* buf = (size >= 0) ? (uint8_t*)malloc((size > 0) ? (size_t)size : 1U) : NULL;
+    if ((buf == NULL) || (fseek(f, 0, SEEK_SET) != 0))
+    {
+        fprintf(stderr, "Can not read %s\n", path);
+        free(buf);
+        fclose(f);
+        return 1;
+    }
+    size_t got = fread(buf, 1U, (size_t)size, f);
+    fclose(f);
+    if (got != (size_t)size)
+    {
+        fprintf(stderr, "Can not read %s\n", path);
+        free(buf);
+        return 1;
+    }
+    LLVMFuzzerTestOneInput(buf, got);
+    free(buf);
+    printf("Replayed %s (%lu bytes)\n", path, (unsigned long)got);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long long runs = 1000U;
+    unsigned long long seed = 1U;
+    unsigned long long steps = 256U;
+    unsigned long long soak = 0U;
+    unsigned long long trace = 0U;
+    unsigned long long replays = 10U;
+    unsigned long long record = 1048576U;
+    int replayed = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (parseFlag(argv[i], "-runs", &runs) || parseFlag(argv[i], "-seed", &seed) ||
+            parseFlag(argv[i], "-steps", &steps) || parseFlag(argv[i], "-soak", &soak) ||
+            parseFlag(argv[i], "-trace", &trace) || parseFlag(argv[i], "-replays", &replays) ||
+            parseFlag(argv[i], "-record", &record))
+        {
+            mTrace = (trace != 0U);
+            if (mTrace)
+            {
+                setvbuf(stdout, NULL, _IONBF, 0);
+            }
+            continue;
+        }
+        if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 2;
+        }
+        if (replayFile(argv[i]) != 0)
+        {
+            return 1;
+        }
+        replayed++;
+    }
+    if (replayed > 0)
+    {
+        return 0;
+    }
+
+    if ((replays > 0U) && (record > 0U))
+    {
+        mReplay = (ReplayOp_t*)malloc((size_t)record * sizeof(ReplayOp_t));
+        if (mReplay == NULL)
+        {
+            fprintf(stderr, "Can not allocate a recording of %llu calls\n", record);
+            return 1;
+        }
+        mReplayCapacity = (size_t)record;
+    }
+
+    clock_t start = clock();
+    if (soak > 0U)
+    {
+        // One endless stream, the occasional Clear keeps it from settling into a single shape
+        fuzzBegin(NULL, 0U, seed);
+        do
+        {
+            for (uint32_t i = 0; i < 4096U; i++)
+            {
+                fuzzStep();
+            }
+        } while ((unsigned long long)((clock() - start) / CLOCKS_PER_SEC) < soak);
+    }
+    else
+    {
+        for (unsigned long long r = 0; r < runs; r++)
+        {
+            fuzzBegin(NULL, 0U, seed + r);
+            for (unsigned long long s = 0; s < steps; s++)
+            {
+                fuzzStep();
+            }
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%llu steps, %llu callbacks fired in %.2f s", (unsigned long long)mSteps, (unsigned long long)mFires, seconds);
+    if (seconds > 0.0)
+    {
+        printf(", %.0f steps/s, %.0f callbacks/s", (double)mSteps / seconds, (double)mFires / seconds);
+    }
+    printf("\n");
+    if (mReplay != NULL)
+    {
+        replayBatches(replays);
+        free(mReplay);
+        mReplay = NULL;
+    }
+    return 0;
+}
+#endif
@@ -145,6 +145,106 @@ void test_ActionScheduler_UnscheduleFinishedAction()
     TEST_ASSERT_FALSE(ActionScheduler_Unschedule(&id1));
 }
 
+static ActionSchedulerId_t selfId = ACTION_SCHEDULER_ID_INVALID;
+static ActionSchedulerId_t reusedId = ACTION_SCHEDULER_ID_INVALID;
+static int reusedExecuted = 0;
+
+static ActionReturn_t reusedCallback(void *arg)
+{
+    reusedExecuted++;
+    return ACTION_ONESHOT;
+}
+
+// Unschedule itself, then schedule until a new event takes this very slot, the reload must leave that new event alone
+static ActionReturn_t selfReusingCallback(void *arg)
+{
+    uint8_t selfSlot = (uint8_t)(selfId & 0xffU);
+    TEST_ASSERT_TRUE(ActionScheduler_Unschedule(&selfId));
+    for (int i = 0; i < MAX_ACTION_SCHEDULER_NODES; i++)
+    {
+        ActionSchedulerId_t filler = ActionScheduler_Schedule(1000, callback1, NULL);
+        TEST_ASSERT_NOT_EQUAL(ACTION_SCHEDULER_ID_INVALID, filler);
+        if ((uint8_t)(filler & 0xffU) == selfSlot)
+        {
+            // The filler landed in our slot as the timeline end, swap it for the event under test
+            TEST_ASSERT_TRUE(ActionScheduler_Unschedule(&filler));
+            reusedId = ActionScheduler_Schedule(50, reusedCallback, NULL);
+            break;
+        }
+    }
+    TEST_ASSERT_EQUAL(selfSlot, (uint8_t)(reusedId & 0xffU));
+    return ACTION_RELOAD;
+}
+
+void test_ActionScheduler_UnscheduleSelfSlotReused()
+{
+    ActionScheduler_Clear();
+    reusedId = ACTION_SCHEDULER_ID_INVALID;
+    reusedExecuted = 0;
+    selfId = ActionScheduler_ScheduleReload(10, 20, selfReusingCallback, NULL);
+    ActionScheduler_Schedule(100, callback1, NULL);
+
+    TEST_ASSERT_TRUE(ActionScheduler_Proceed(10));
+    TEST_ASSERT_FALSE(ActionScheduler_IsCallbackArmed(selfReusingCallback));
+    TEST_ASSERT_TRUE(ActionScheduler_IsCallbackArmed(reusedCallback));
+    TEST_ASSERT_EQUAL_UINT32(50, ActionScheduler_GetNextEventDelay());
+
+    ActionScheduler_Proceed(50);
+    TEST_ASSERT_EQUAL(1, reusedExecuted);
+    TEST_ASSERT_FALSE(ActionScheduler_IsCallbackArmed(reusedCallback));
+    TEST_ASSERT_EQUAL_UINT32(40, ActionScheduler_GetNextEventDelay());
+}
+
+// The running event is isolated from the timeline, UnscheduleAll must still find it, same as an Unschedule by id
+static ActionReturn_t unscheduleAllSelfCallback(void *arg)
+{
+    TEST_ASSERT_TRUE(ActionScheduler_UnscheduleAll(unscheduleAllSelfCallback));
+    return ACTION_RELOAD;
+}
+
+void test_ActionScheduler_UnscheduleAllInsideCallback()
+{
+    ActionScheduler_Clear();
+    ActionScheduler_ScheduleReload(10, 10, unscheduleAllSelfCallback, NULL);
+    ActionScheduler_Schedule(100, callback1, NULL);
+
+    TEST_ASSERT_TRUE(ActionScheduler_Proceed(10));
+    TEST_ASSERT_FALSE(ActionScheduler_IsCallbackArmed(unscheduleAllSelfCallback));
+    TEST_ASSERT_TRUE(ActionScheduler_IsCallbackArmed(callback1));
+    TEST_ASSERT_EQUAL_UINT32(90, ActionScheduler_GetNextEventDelay());
+}
+
+static ActionSchedulerId_t clearingId = ACTION_SCHEDULER_ID_INVALID;
+
+// Clear, then schedule again, right after the Clear the new event takes this very slot with the very same counter
+static ActionReturn_t clearingCallback(void *arg)
+{
+    ActionScheduler_Clear();
+    reusedId = ActionScheduler_Schedule(30, reusedCallback, NULL);
+    TEST_ASSERT_EQUAL(clearingId, reusedId);
+    return ACTION_RELOAD;
+}
+
+void test_ActionScheduler_ClearInsideCallbackDropsReload()
+{
+    ActionScheduler_Clear();
+    reusedId = ACTION_SCHEDULER_ID_INVALID;
+    reusedExecuted = 0;
+    clearingId = ActionScheduler_ScheduleReload(10, 10, clearingCallback, NULL);
+    ActionScheduler_Schedule(100, callback1, NULL);
+
+    TEST_ASSERT_TRUE(ActionScheduler_Proceed(10));
+    TEST_ASSERT_FALSE(ActionScheduler_IsCallbackArmed(clearingCallback));
+    TEST_ASSERT_FALSE(ActionScheduler_IsCallbackArmed(callback1));
+    TEST_ASSERT_TRUE(ActionScheduler_IsCallbackArmed(reusedCallback));
+    TEST_ASSERT_EQUAL_UINT32(30, ActionScheduler_GetNextEventDelay());
+
+    ActionScheduler_Proceed(30);
+    TEST_ASSERT_EQUAL(1, reusedExecuted);
+    TEST_ASSERT_FALSE(ActionScheduler_IsCallbackArmed(reusedCallback));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, ActionScheduler_GetNextEventDelay());
+}
+
 int main()
 {
     UNITY_BEGIN();
@@ -156,5 +256,8 @@ int main()
     RUN_TEST(test_ActionScheduler_IsCallbackArmed);
     RUN_TEST(test_ActionScheduler_LargeNumberOfCallbacks);
     RUN_TEST(test_ActionScheduler_UnscheduleFinishedAction);
+    RUN_TEST(test_ActionScheduler_UnscheduleSelfSlotReused);
+    RUN_TEST(test_ActionScheduler_UnscheduleAllInsideCallback);
+    RUN_TEST(test_ActionScheduler_ClearInsideCallbackDropsReload);
     return UNITY_END();
 }
\ No newline at end of file